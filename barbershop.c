@@ -0,0 +1,1945 @@
+#define _GNU_SOURCE // Necessário para afinidade de CPU (pthread_attr_setaffinity_np)
+
+#include "barbershop.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdint.h>
+#include <pthread.h>
+#include <sched.h>
+#include <unistd.h>
+#include <time.h>
+#include <string.h>
+#include <sys/time.h>
+#include <limits.h>
+
+// Controlador do pool elástico: amostra a fila a cada AUTOSCALE_TICK_MS e decide
+// com base na média de AUTOSCALE_WINDOW amostras. Limiares distintos para subir e
+// descer, mais o intervalo mínimo entre mudanças, dão a histerese
+#define AUTOSCALE_TICK_MS 250
+#define AUTOSCALE_WINDOW 8
+#define AUTOSCALE_UP_BACKLOG 1.0     // Fila média por barbeiro ativo para contratar
+#define AUTOSCALE_DOWN_BACKLOG 0.25  // Fila média por barbeiro ativo para estacionar
+
+// Controle de admissão adaptativo (inspirado no CoDel): a cada intervalo compara
+// o p99 das últimas permanências e o menor atraso de fila do intervalo com o alvo.
+// Acima do alvo o limite cai multiplicativamente; com folga sobe de um em um
+#define ADMISSION_INTERVAL_MS 500
+#define ADMISSION_WINDOW 64          // Permanências recentes consideradas no p99
+#define ADMISSION_MIN_SAMPLES 8      // Mínimo de amostras para confiar no p99
+
+// No modo pipeline o barbeiro reserva o próximo cliente do sofá quando faltam
+// PIPELINE_LEAD_MS (ou 1/4 do corte, o que for menor) para terminar o corte atual
+#define PIPELINE_LEAD_MS 300
+
+// Pilha das threads com lock_memory. Com mlockall(MCL_FUTURE) cada pilha é
+// travada inteira na criação e conta no RLIMIT_MEMLOCK; com a pilha padrão
+// (8 MB) poucas threads já estouram o limite usual e pthread_create falha
+#define LOCKED_STACK_SIZE (64 * 1024)
+
+// Alinhamento das alocações da arena
+#define ARENA_ALIGN 16
+
+// Fila FIFO circular. A capacidade é fixada na preparação da execução, então
+// enqueue/dequeue nunca alocam memória
+typedef struct Queue {
+    int* slots;
+    int capacity;
+    int head;
+    int size;
+} Queue;
+
+// Entrada do sofá ordenada por (key, seq); seq desempata na ordem de chegada
+typedef struct {
+    int customer_id;
+    int64_t key;
+    unsigned long seq;
+} SofaEntry;
+
+// Heap binário de mínimo usado para o sofá e para os clientes em pé esperando
+// lugar nele. A capacidade cobre o pior caso (sofa_capacity sentados, no máximo
+// max_capacity em pé), então push nunca estoura
+typedef struct {
+    SofaEntry* entries;
+    int capacity;
+    int size;
+} SofaQueue;
+
+// Estado do cliente
+typedef struct {
+    int id;
+    int class_id;
+    int is_getting_haircut;
+    int haircut_done;
+    int is_paying;
+    int payment_done;
+    int seated_in_chair;  // Nova flag para confirmar que cliente sentou
+    int chair_ready;      // Cadeira liberada para o cliente reservado (modo pipeline)
+    int sofa_granted;     // Lugar no sofá repassado a este cliente em pé
+    // Instantes (ns, CLOCK_MONOTONIC) de cada sinal, usados na medição de latência
+    uint64_t called_ns;
+    uint64_t seated_ns;
+    uint64_t haircut_done_ns;
+    uint64_t payment_done_ns;
+    uint64_t payment_queued_ns;
+    uint64_t chair_ready_ns;
+    // Instantes para as estatísticas por classe
+    uint64_t entered_ns;
+    uint64_t sofa_ns;
+    uint64_t left_ns;
+} CustomerState;
+
+// Handoffs instrumentados (sinal -> thread acordada retoma execução)
+typedef enum {
+    HANDOFF_CALL_TO_SEATED,        // Barbeiro chama -> cliente senta na cadeira
+    HANDOFF_SEATED_TO_BARBER,      // Cliente senta -> barbeiro retoma
+    HANDOFF_CUT_TO_CUSTOMER,       // Corte terminado -> cliente retoma
+    HANDOFF_PAYMENT_TO_CUSTOMER,   // Pagamento processado -> cliente retoma
+    HANDOFF_COUNT
+} Handoff;
+
+// Histograma log2 em microssegundos: bucket i cobre [2^i, 2^(i+1)) us
+#define LATENCY_BUCKETS 24
+
+typedef struct {
+    const char* name;
+    unsigned long count;
+    uint64_t sum_ns;
+    uint64_t min_ns;
+    uint64_t max_ns;
+    unsigned long buckets[LATENCY_BUCKETS];
+    unsigned long fast_path;     // Predicado já verdadeiro: a thread nem bloqueou
+} LatencyHistogram;
+
+static const char* const handoff_names[HANDOFF_COUNT] = {
+    [HANDOFF_CALL_TO_SEATED]      = "chamada -> cliente sentou",
+    [HANDOFF_SEATED_TO_BARBER]    = "sentou -> barbeiro retoma",
+    [HANDOFF_CUT_TO_CUSTOMER]     = "corte feito -> cliente retoma",
+    [HANDOFF_PAYMENT_TO_CUSTOMER] = "pagamento feito -> cliente retoma",
+};
+
+// Argumento das threads de barbeiro e cliente
+typedef struct {
+    Shop* shop;
+    int id;
+} ThreadArg;
+
+// Arena de memória de uma execução: um único bloco, fatiado sequencialmente em
+// shopReset e reaproveitado enquanto a configuração couber nele
+typedef struct {
+    char* base;
+    size_t capacity;
+    size_t used;
+} Arena;
+
+// Contexto de uma simulação: tudo que antes eram variáveis globais
+struct Shop {
+    ShopConfig config;               // Cópia intacta da configuração recebida
+    Arena arena;
+    int has_run;                     // shopRun já executou desde o último reset
+    
+    // Valores efetivos derivados da configuração em shopReset
+    ShopCustomerClass classes[SHOP_MAX_CUSTOMER_CLASSES]; // Classe "padrão" se não houver explícitas
+    int num_classes;
+    int num_barbers;                 // Threads de barbeiro (max_barbers no modo elástico)
+    
+    int customers_in_shop;
+    int customers_on_sofa;
+    int customers_being_served;
+    int customers_paying;
+    int total_visits;
+    int customers_attended;
+    int customers_balked;
+    int expected_customers;          // Clientes que de fato chegam (menos se a criação falhar)
+    unsigned long shop_events;       // Saídas e desistências, para o monitor não perder sinais
+    int should_stop;                 // Lido via shouldStop, sem lock
+    double elapsed_s;
+    
+    // Estado do pool de barbeiros (protegido por pool_mutex)
+    int active_barbers;              // Barbeiros com id <= active_barbers trabalham
+    int peak_active_barbers;
+    int scale_up_events;
+    int scale_down_events;
+    uint64_t barber_active_ns;       // Tempo total de barbeiros não estacionados
+    
+    // Limite efetivo de admissão. Escrito só pelo controlador, que não segura
+    // shop_mutex; a entrada da loja o lê sob shop_mutex, junto com
+    // customers_in_shop (acessos atômicos relaxados, basta um valor recente)
+    int admission_limit;
+    
+    // Sinais do controle de admissão (protegidos por admission_mutex)
+    uint64_t sojourn_window[ADMISSION_WINDOW];
+    int sojourn_samples;
+    uint64_t interval_min_delay_ns;  // Menor atraso de fila no intervalo
+    int admission_min_limit;
+    int admission_decreases;
+    int admission_increases;
+    long admission_limit_sum;        // Soma do limite por intervalo (para a média)
+    int admission_ticks;
+    
+    // Tempo em que o barbeiro fica parado entre comprometer-se com um cliente e
+    // começar o corte (protegido por latency_mutex)
+    uint64_t handoff_idle_ns;
+    uint64_t handoff_idle_max_ns;
+    int handoffs;
+    
+    // Modo pipeline: espera do cliente entre ser chamado e a cadeira ficar livre
+    // (protegida por latency_mutex) e reservas assumidas (protegida por sofa_mutex)
+    uint64_t chair_wait_ns;
+    int chair_waits;
+    int reservation_takeovers;
+    
+    LatencyHistogram latency_histograms[HANDOFF_COUNT];
+    int attr_error_shown;            // Erro de atributos recusados já exibido
+    
+    // Estruturas da execução, todas dentro da arena
+    SofaQueue* sofa_queue;           // Fila para o sofá (ordem definida pela disciplina)
+    SofaQueue* standing_queue;       // Clientes em pé esperando lugar (mesma disciplina)
+    unsigned long sofa_arrivals;     // Sequência de chegada ao sofá (protegida por sofa_mutex)
+    Queue* payment_queue;            // Fila para pagamento
+    CustomerState* customer_states;  // Array de estados dos clientes
+    pthread_t* barber_threads;
+    ThreadArg* barber_args;
+    int* reservations;               // Cliente reservado por barbeiro, -1 = nenhum (sofa_mutex)
+    pthread_t* customer_threads;
+    ThreadArg* customer_args;
+    uint64_t* scratch_a;             // Amostras ordenadas nos relatórios
+    uint64_t* scratch_b;
+    
+    // Mutexes simplificados
+    pthread_mutex_t shop_mutex;      // Controla entrada/saída da loja
+    pthread_mutex_t sofa_mutex;      // Controla sofá
+    pthread_mutex_t chair_mutex;     // Controla cadeiras de corte
+    pthread_mutex_t payment_mutex;   // Controla pagamentos
+    pthread_mutex_t log_mutex;       // Para logs thread-safe
+    pthread_mutex_t latency_mutex;   // Protege os histogramas de latência
+    pthread_mutex_t pool_mutex;      // Controla o pool de barbeiros
+    pthread_mutex_t admission_mutex; // Sinais do controle de admissão
+    
+    // Variáveis de condição
+    pthread_cond_t sofa_available;   // Lugar no sofá disponível
+    pthread_cond_t barber_available; // Barbeiro disponível
+    pthread_cond_t haircut_done;     // Corte terminado
+    pthread_cond_t payment_ready;    // Cliente pronto para pagar
+    pthread_cond_t payment_done_cond; // Pagamento processado
+    pthread_cond_t customer_seated;  // Cliente sentou na cadeira
+    pthread_cond_t barber_unparked;  // Pool cresceu ou simulação terminou
+    pthread_cond_t chair_ready_cond; // Cadeira liberada para cliente reservado
+    pthread_cond_t monitor_wake;     // Cliente saiu ou desistiu (sob shop_mutex)
+    pthread_cond_t stop_cond;        // Fim da simulação, acorda os controladores
+};
+
+// Configuração padrão
+static const ShopConfig default_config = {
+    .max_customers = 50,
+    .max_capacity = 10,        // Reduzido para criar mais pressão
+    .num_barbers = 2,          // Reduzido para criar gargalo
+    .sofa_capacity = 3,        // Reduzido para criar mais concorrência
+    .min_haircut_time = 2000,  // Aumentado para criar mais demora
+    .max_haircut_time = 8000,  // Aumentado significativamente
+    .min_payment_time = 1000,  // Aumentado
+    .max_payment_time = 4000,  // Aumentado
+    .min_arrival_interval = 50,    // Chegadas mais frequentes
+    .max_arrival_interval = 800,   // Mas com menos variação máxima
+    .variability_factor = 7,       // Mais variabilidade
+    .barber_fifo_priority = 0,
+    .lock_memory = 0,
+    .measure_latency = 0,
+    .autoscale = 0,
+    .num_classes = 0,
+    .dispatch = SHOP_DISPATCH_FIFO,
+    .aging_ms = 2000,
+    .admission_target_ms = 0,
+    .pipeline = 0,
+    .verbose = 1
+};
+
+// Funções para manejo de fila FIFO
+static void enqueue(Queue* q, int customer_id) {
+    if (q->size >= q->capacity) return; // Não deve ocorrer: limitada pela capacidade da loja
+    
+    q->slots[(q->head + q->size) % q->capacity] = customer_id;
+    q->size++;
+}
+
+static int dequeue(Queue* q) {
+    if (q->size == 0) return -1;
+    
+    int customer_id = q->slots[q->head];
+    q->head = (q->head + 1) % q->capacity;
+    q->size--;
+    return customer_id;
+}
+
+static int isEmpty(Queue* q) {
+    return q->size == 0;
+}
+
+// Funções para manejo do heap do sofá
+static int sofaEntryBefore(const SofaEntry* a, const SofaEntry* b) {
+    return a->key < b->key || (a->key == b->key && a->seq < b->seq);
+}
+
+static void sofaPush(SofaQueue* q, int customer_id, int64_t key, unsigned long seq) {
+    if (q->size >= q->capacity) return; // Não deve ocorrer: lugar já foi reservado
+    
+    int i = q->size++;
+    SofaEntry entry = { .customer_id = customer_id, .key = key, .seq = seq };
+    while (i > 0) {
+        int parent = (i - 1) / 2;
+        if (!sofaEntryBefore(&entry, &q->entries[parent])) break;
+        q->entries[i] = q->entries[parent];
+        i = parent;
+    }
+    q->entries[i] = entry;
+}
+
+static int sofaPop(SofaQueue* q) {
+    if (q->size == 0) return -1;
+    
+    int customer_id = q->entries[0].customer_id;
+    SofaEntry last = q->entries[--q->size];
+    int i = 0;
+    while (1) {
+        int child = 2 * i + 1;
+        if (child >= q->size) break;
+        if (child + 1 < q->size && sofaEntryBefore(&q->entries[child + 1], &q->entries[child])) {
+            child++;
+        }
+        if (!sofaEntryBefore(&q->entries[child], &last)) break;
+        q->entries[i] = q->entries[child];
+        i = child;
+    }
+    if (q->size > 0) {
+        q->entries[i] = last;
+    }
+    return customer_id;
+}
+
+// Fim da simulação, lido sem lock nos laços das threads (escrito só pelo monitor)
+// Avisa o monitor de que a condição de parada pode ter mudado (chamar com shop_mutex)
+static void notifyMonitor(Shop* shop) {
+    shop->shop_events++;
+    pthread_cond_signal(&shop->monitor_wake);
+}
+
+// Espera em cond por até timeout_ms. O prazo usa o relógio padrão das condições
+// (CLOCK_REALTIME), disponível também no macOS
+static void timedWait(pthread_cond_t* cond, pthread_mutex_t* mutex, int timeout_ms) {
+    struct timespec deadline;
+    clock_gettime(CLOCK_REALTIME, &deadline);
+    deadline.tv_sec += timeout_ms / 1000;
+    deadline.tv_nsec += (long)(timeout_ms % 1000) * 1000000L;
+    if (deadline.tv_nsec >= 1000000000L) {
+        deadline.tv_sec++;
+        deadline.tv_nsec -= 1000000000L;
+    }
+    pthread_cond_timedwait(cond, mutex, &deadline);
+}
+
+static int shouldStop(Shop* shop) {
+    return __atomic_load_n(&shop->should_stop, __ATOMIC_RELAXED);
+}
+
+// Dorme até interval_ms, acordando antes se a simulação terminar. Retorna se
+// a simulação terminou
+static int sleepUnlessStopped(Shop* shop, int interval_ms) {
+    pthread_mutex_lock(&shop->shop_mutex);
+    if (!shouldStop(shop)) {
+        timedWait(&shop->stop_cond, &shop->shop_mutex, interval_ms);
+    }
+    int stopped = shouldStop(shop);
+    pthread_mutex_unlock(&shop->shop_mutex);
+    return stopped;
+}
+
+// Função para obter timestamp
+static void getCurrentTime(char* buffer) {
+    struct timeval tv;
+    struct tm timeinfo;
+    gettimeofday(&tv, NULL);
+    localtime_r(&tv.tv_sec, &timeinfo); // Reentrante: várias simulações podem registrar ao mesmo tempo
+    
+    snprintf(buffer, 100, "[%02d:%02d:%02d.%03d]", 
+             timeinfo.tm_hour, timeinfo.tm_min, timeinfo.tm_sec, (int)(tv.tv_usec/1000));
+}
+
+// Função para log thread-safe
+static void logMessage(Shop* shop, const char* message) {
+    if (!shop->config.verbose) return;
+    
+    pthread_mutex_lock(&shop->log_mutex);
+    char timestamp[100];
+    getCurrentTime(timestamp);
+    printf("%s %s\n", timestamp, message);
+    fflush(stdout);
+    pthread_mutex_unlock(&shop->log_mutex);
+}
+
+// Tempo monotônico em nanossegundos (para medir latências)
+static uint64_t monotonicNs() {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t)ts.tv_sec * 1000000000ULL + (uint64_t)ts.tv_nsec;
+}
+
+// Registra a latência de um handoff. A origem é o mais tarde entre o sinal e o
+// instante em que a thread começou a esperar, para não contar tempo em que ela
+// ainda não estava bloqueada (ex: cliente ainda "sentando" no sofá). Se a thread
+// não chegou a dormir em pthread_cond_wait (waited = 0), o intervalo só mediria
+// a aquisição do mutex: conta apenas como atalho, fora do histograma
+static void recordLatency(Shop* shop, Handoff handoff, int waited, uint64_t signal_ns, uint64_t wait_start_ns, uint64_t resumed_ns) {
+    if (!shop->config.measure_latency || signal_ns == 0) return;
+    
+    if (!waited) {
+        pthread_mutex_lock(&shop->latency_mutex);
+        shop->latency_histograms[handoff].fast_path++;
+        pthread_mutex_unlock(&shop->latency_mutex);
+        return;
+    }
+
+    uint64_t start_ns = signal_ns > wait_start_ns ? signal_ns : wait_start_ns;
+    uint64_t latency_ns = resumed_ns > start_ns ? resumed_ns - start_ns : 0;
+    uint64_t latency_us = latency_ns / 1000;
+    int bucket = 0;
+    while (latency_us > 1 && bucket < LATENCY_BUCKETS - 1) {
+        latency_us >>= 1;
+        bucket++;
+    }
+
+    pthread_mutex_lock(&shop->latency_mutex);
+    LatencyHistogram* h = &shop->latency_histograms[handoff];
+    if (h->count == 0 || latency_ns < h->min_ns) h->min_ns = latency_ns;
+    if (latency_ns > h->max_ns) h->max_ns = latency_ns;
+    h->count++;
+    h->sum_ns += latency_ns;
+    h->buckets[bucket]++;
+    pthread_mutex_unlock(&shop->latency_mutex);
+}
+
+// Percentil aproximado (limite superior do bucket) em microssegundos
+static unsigned long latencyPercentileUs(const LatencyHistogram* h, int percentile) {
+    unsigned long target = (h->count * percentile + 99) / 100;
+    unsigned long seen = 0;
+    for (int i = 0; i < LATENCY_BUCKETS; i++) {
+        seen += h->buckets[i];
+        if (seen >= target) return 2UL << i;
+    }
+    return 2UL << (LATENCY_BUCKETS - 1);
+}
+
+// Exibe os histogramas de latência de acordar de cada handoff
+static void printLatencyHistograms(Shop* shop) {
+    printf("\n=== LATÊNCIA DE ACORDAR POR HANDOFF (us) ===\n");
+    printf("Afinidade: barbeiros %s, clientes %s; barbeiros em %s\n",
+           shop->config.pin_barbers.count > 0 ? "fixados" : "sem afinidade",
+           shop->config.pin_customers.count > 0 ? "fixados" : "sem afinidade",
+           shop->config.barber_fifo_priority > 0 ? "SCHED_FIFO" : "SCHED_OTHER");
+    for (int i = 0; i < HANDOFF_COUNT; i++) {
+        const LatencyHistogram* h = &shop->latency_histograms[i];
+        printf("\n%s: %lu amostras (%lu sem bloquear, fora do histograma)\n",
+               handoff_names[i], h->count, h->fast_path);
+        if (h->count == 0) continue;
+
+        printf("  min=%.1f média=%.1f max=%.1f p50<=%lu p99<=%lu\n",
+               h->min_ns / 1000.0, (double)h->sum_ns / h->count / 1000.0, h->max_ns / 1000.0,
+               latencyPercentileUs(h, 50), latencyPercentileUs(h, 99));
+
+        unsigned long peak = 0;
+        for (int b = 0; b < LATENCY_BUCKETS; b++) {
+            if (h->buckets[b] > peak) peak = h->buckets[b];
+        }
+        for (int b = 0; b < LATENCY_BUCKETS; b++) {
+            if (h->buckets[b] == 0) continue;
+            int bar = (int)(h->buckets[b] * 40 / peak);
+            printf("  %8lu - %-8lu | %-40.*s %lu\n", b == 0 ? 0UL : 1UL << b, 2UL << b,
+                   bar > 0 ? bar : 1, "########################################", h->buckets[b]);
+        }
+    }
+}
+
+// Seed thread-local para aleatoriedade
+static __thread unsigned int thread_seed = 0;
+
+// Função para inicializar seed da thread
+static void initThreadSeed() {
+    if (thread_seed == 0) {
+        struct timeval tv;
+        gettimeofday(&tv, NULL);
+        thread_seed = (unsigned int)(tv.tv_sec ^ tv.tv_usec ^ (unsigned long)pthread_self());
+    }
+}
+
+// Função para gerar tempo aleatório thread-safe
+static int randomTime(int min_time, int max_time) {
+    initThreadSeed();
+    return min_time + (rand_r(&thread_seed) % (max_time - min_time + 1));
+}
+
+// Função para gerar tempo aleatório com variabilidade aumentada
+static int variableRandomTime(int base_min, int base_max, int variability_factor) {
+    initThreadSeed();
+    // Aumenta o range baseado no fator de variabilidade (1-10)
+    int range_expansion = variability_factor * 20; // 20ms por fator
+    int new_min = base_min;
+    int new_max = base_max + range_expansion;
+    
+    // Com 30% de chance, gera um tempo muito mais longo (picos de variabilidade)
+    if (rand_r(&thread_seed) % 100 < 30) {
+        new_max = base_max + (range_expansion * 3);
+    }
+    
+    return randomTime(new_min, new_max);
+}
+
+// Limite de admissão atual (leitura atômica: o controlador escreve sem shop_mutex)
+static int admissionLimit(Shop* shop) {
+    return __atomic_load_n(&shop->admission_limit, __ATOMIC_RELAXED);
+}
+
+// Registra atraso de fila (sofá ou pagamento) para o sinal de fila persistente
+static void recordQueueDelay(Shop* shop, uint64_t delay_ns) {
+    if (!shop->config.admission_target_ms) return;
+    
+    pthread_mutex_lock(&shop->admission_mutex);
+    if (delay_ns < shop->interval_min_delay_ns) {
+        shop->interval_min_delay_ns = delay_ns;
+    }
+    pthread_mutex_unlock(&shop->admission_mutex);
+}
+
+// Registra a permanência de um cliente que saiu da loja
+static void recordSojourn(Shop* shop, uint64_t sojourn_ns) {
+    if (!shop->config.admission_target_ms) return;
+    
+    pthread_mutex_lock(&shop->admission_mutex);
+    shop->sojourn_window[shop->sojourn_samples % ADMISSION_WINDOW] = sojourn_ns;
+    shop->sojourn_samples++;
+    pthread_mutex_unlock(&shop->admission_mutex);
+}
+
+// Funções do cliente
+static int enterShop(Shop* shop, int customer_id) {
+    char log_msg[200];
+    
+    // Tempo para decidir entrar na loja
+    usleep(variableRandomTime(50, 200, shop->config.variability_factor) * 1000);
+    
+    pthread_mutex_lock(&shop->shop_mutex);
+    
+    snprintf(log_msg, sizeof(log_msg), "Cliente %d: Tentando entrar na loja", customer_id);
+    logMessage(shop, log_msg);
+    
+    // Verificação rigorosa da capacidade (fixa ou ajustada pelo controle de admissão)
+    int limit = admissionLimit(shop);
+    if (shop->customers_in_shop >= limit) {
+        snprintf(log_msg, sizeof(log_msg), "Cliente %d: Loja lotada - saindo (balk)", customer_id);
+        logMessage(shop, log_msg);
+        shop->total_visits++;
+        shop->customers_balked++;
+        notifyMonitor(shop);
+        pthread_mutex_unlock(&shop->shop_mutex);
+        return 0; // Não conseguiu entrar
+    }
+    
+    // Incrementa atomicamente
+    shop->customers_in_shop++;
+    shop->total_visits++;
+    shop->customer_states[customer_id - 1].entered_ns = monotonicNs();
+    
+    snprintf(log_msg, sizeof(log_msg), "Cliente %d: Entrou na loja (%d/%d)", 
+             customer_id, shop->customers_in_shop, limit);
+    logMessage(shop, log_msg);
+    
+    pthread_mutex_unlock(&shop->shop_mutex);
+    return 1; // Conseguiu entrar
+}
+
+// Chave de ordenação do sofá conforme a disciplina (menor sai primeiro). Vale
+// tanto para quem está sentado quanto para quem espera lugar em pé.
+// Na disciplina "priority" o envelhecimento é embutido na chave: cada nível de
+// prioridade equivale a aging_ms de espera desde a entrada na loja, então a chave
+// não muda com o tempo e nenhuma classe espera mais que (níveis * aging_ms) a
+// mais que as outras, contando também o tempo em pé
+static int64_t sofaKey(Shop* shop, int customer_id) {
+    const ShopCustomerClass* cls = &shop->classes[shop->customer_states[customer_id - 1].class_id];
+    
+    switch (shop->config.dispatch) {
+        case SHOP_DISPATCH_SEPT:
+            return (cls->min_haircut_time + cls->max_haircut_time) / 2;
+        case SHOP_DISPATCH_PRIORITY:
+            return (int64_t)(shop->customer_states[customer_id - 1].entered_ns / 1000000) +
+                   (int64_t)cls->priority * shop->config.aging_ms;
+        case SHOP_DISPATCH_FIFO:
+        default:
+            return 0; // Desempate por seq mantém a ordem de chegada
+    }
+}
+
+static void sitOnSofa(Shop* shop, int customer_id) {
+    char log_msg[200];
+    
+    pthread_mutex_lock(&shop->sofa_mutex);
+    
+    // Sem lugar (ou com gente em pé na frente), espera em pé na fila da
+    // disciplina. Quem libera um lugar o repassa direto ao primeiro dessa fila
+    // (releaseSofaSeat), então a ordem não depende de qual thread acorda antes
+    if (shop->customers_on_sofa >= shop->config.sofa_capacity || shop->standing_queue->size > 0) {
+        sofaPush(shop->standing_queue, customer_id, sofaKey(shop, customer_id), shop->sofa_arrivals++);
+        snprintf(log_msg, sizeof(log_msg), "Cliente %d: Esperando lugar no sofá", customer_id);
+        logMessage(shop, log_msg);
+        
+        while (!shop->customer_states[customer_id - 1].sofa_granted) {
+            pthread_cond_wait(&shop->sofa_available, &shop->sofa_mutex);
+        }
+        shop->customer_states[customer_id - 1].sofa_granted = 0;
+    } else {
+        shop->customers_on_sofa++;
+    }
+    
+    shop->customer_states[customer_id - 1].sofa_ns = monotonicNs();
+    sofaPush(shop->sofa_queue, customer_id, sofaKey(shop, customer_id), shop->sofa_arrivals++);
+    
+    snprintf(log_msg, sizeof(log_msg), "Cliente %d: Sentou no sofá (%d/%d) - esperando barbeiro", 
+             customer_id, shop->customers_on_sofa, shop->config.sofa_capacity);
+    logMessage(shop, log_msg);
+    
+    // Acorda barbeiros
+    pthread_cond_broadcast(&shop->barber_available);
+    
+    pthread_mutex_unlock(&shop->sofa_mutex);
+    
+    // Tempo no sofá
+    usleep(variableRandomTime(100, 300, shop->config.variability_factor) * 1000);
+}
+
+// Libera um lugar no sofá. Havendo clientes em pé, o lugar passa ao primeiro
+// deles pela disciplina, sem nunca ficar vago
+static void releaseSofaSeat(Shop* shop) {
+    pthread_mutex_lock(&shop->sofa_mutex);
+    if (shop->standing_queue->size > 0) {
+        int customer_id = sofaPop(shop->standing_queue);
+        shop->customer_states[customer_id - 1].sofa_granted = 1;
+        pthread_cond_broadcast(&shop->sofa_available);
+    } else {
+        shop->customers_on_sofa--;
+    }
+    pthread_mutex_unlock(&shop->sofa_mutex);
+}
+
+static void getHairCut(Shop* shop, int customer_id) {
+    char log_msg[200];
+    
+    // Espera ser chamado pelo barbeiro - usa mutex separado para evitar deadlock
+    uint64_t wait_start_ns = monotonicNs();
+    int waited = 0;
+    pthread_mutex_lock(&shop->shop_mutex);
+    if (!shop->customer_states[customer_id - 1].is_getting_haircut) {
+        snprintf(log_msg, sizeof(log_msg), "Cliente %d: Esperando ser chamado para corte", customer_id);
+        logMessage(shop, log_msg);
+        
+        while (!shop->customer_states[customer_id - 1].is_getting_haircut) {
+            pthread_cond_wait(&shop->barber_available, &shop->shop_mutex);
+            waited = 1;
+        }
+    }
+    pthread_mutex_unlock(&shop->shop_mutex);
+    
+    uint64_t signal_ns = shop->customer_states[customer_id - 1].called_ns;
+    
+    if (shop->config.pipeline) {
+        // No pipeline o próprio cliente libera o lugar no sofá, sem passar pelo
+        // barbeiro, e depois espera a cadeira ficar livre
+        releaseSofaSeat(shop);
+        
+        wait_start_ns = monotonicNs();
+        waited = 0;
+        pthread_mutex_lock(&shop->chair_mutex);
+        while (!shop->customer_states[customer_id - 1].chair_ready) {
+            pthread_cond_wait(&shop->chair_ready_cond, &shop->chair_mutex);
+            waited = 1;
+        }
+        signal_ns = shop->customer_states[customer_id - 1].chair_ready_ns;
+    } else {
+        pthread_mutex_lock(&shop->chair_mutex);
+    }
+    
+    // Marca que sentou na cadeira e avisa o barbeiro antes de qualquer I/O
+    shop->customer_states[customer_id - 1].seated_in_chair = 1;
+    shop->customer_states[customer_id - 1].seated_ns = monotonicNs();
+    recordLatency(shop, HANDOFF_CALL_TO_SEATED, waited, signal_ns, wait_start_ns, shop->customer_states[customer_id - 1].seated_ns);
+    pthread_cond_broadcast(&shop->customer_seated);
+    pthread_mutex_unlock(&shop->chair_mutex);
+    
+    snprintf(log_msg, sizeof(log_msg), "Cliente %d: Sentou na cadeira para corte", customer_id);
+    logMessage(shop, log_msg);
+    
+    // Espera o corte terminar
+    pthread_mutex_lock(&shop->chair_mutex);
+    wait_start_ns = monotonicNs();
+    waited = 0;
+    while (!shop->customer_states[customer_id - 1].haircut_done) {
+        pthread_cond_wait(&shop->haircut_done, &shop->chair_mutex);
+        waited = 1;
+    }
+    recordLatency(shop, HANDOFF_CUT_TO_CUSTOMER, waited, shop->customer_states[customer_id - 1].haircut_done_ns,
+                  wait_start_ns, monotonicNs());
+    
+    snprintf(log_msg, sizeof(log_msg), "Cliente %d: Corte terminado - indo para pagamento", customer_id);
+    logMessage(shop, log_msg);
+    
+    // Reset o estado
+    shop->customer_states[customer_id - 1].is_getting_haircut = 0;
+    shop->customer_states[customer_id - 1].haircut_done = 0;
+    shop->customer_states[customer_id - 1].seated_in_chair = 0;
+    shop->customer_states[customer_id - 1].chair_ready = 0;
+    
+    pthread_mutex_unlock(&shop->chair_mutex);
+}
+
+static void pay(Shop* shop, int customer_id) {
+    char log_msg[200];
+    
+    // Tempo para ir ao caixa
+    usleep(randomTime(80, 200) * 1000);
+    
+    pthread_mutex_lock(&shop->payment_mutex);
+    
+    shop->customers_paying++;
+    shop->customer_states[customer_id - 1].is_paying = 1;
+    enqueue(shop->payment_queue, customer_id);
+    shop->customer_states[customer_id - 1].payment_queued_ns = monotonicNs();
+    
+    snprintf(log_msg, sizeof(log_msg), "Cliente %d: Aguardando processar pagamento", customer_id);
+    logMessage(shop, log_msg);
+    
+    // Acorda barbeiro para processar pagamento
+    pthread_cond_broadcast(&shop->payment_ready);
+    pthread_mutex_unlock(&shop->payment_mutex);
+    
+    // Acorda barbeiro usando o mutex correto (shop->shop_mutex)
+    pthread_mutex_lock(&shop->shop_mutex);
+    pthread_cond_broadcast(&shop->barber_available);
+    pthread_mutex_unlock(&shop->shop_mutex);
+    
+    // Volta a adquirir shop->payment_mutex para esperar
+    uint64_t wait_start_ns = monotonicNs();
+    pthread_mutex_lock(&shop->payment_mutex);
+    
+    // Espera pagamento ser processado
+    int waited = 0;
+    while (!shop->customer_states[customer_id - 1].payment_done) {
+        pthread_cond_wait(&shop->payment_done_cond, &shop->payment_mutex);
+        waited = 1;
+    }
+    recordLatency(shop, HANDOFF_PAYMENT_TO_CUSTOMER, waited, shop->customer_states[customer_id - 1].payment_done_ns,
+                  wait_start_ns, monotonicNs());
+    
+    shop->customers_paying--;
+    shop->customer_states[customer_id - 1].is_paying = 0;
+    shop->customer_states[customer_id - 1].payment_done = 0;
+    
+    snprintf(log_msg, sizeof(log_msg), "Cliente %d: Pagamento concluído - saindo da loja", customer_id);
+    logMessage(shop, log_msg);
+    
+    pthread_mutex_unlock(&shop->payment_mutex);
+    
+    usleep(randomTime(50, 150) * 1000);
+}
+
+// Funções do barbeiro
+
+// Chama para o corte um cliente já retirado do sofá
+static void callCustomer(Shop* shop, int customer_id) {
+    pthread_mutex_lock(&shop->shop_mutex);
+    shop->customers_being_served++;
+    shop->customer_states[customer_id - 1].is_getting_haircut = 1;
+    shop->customer_states[customer_id - 1].called_ns = monotonicNs();
+    pthread_cond_broadcast(&shop->barber_available); // Acorda cliente
+    pthread_mutex_unlock(&shop->shop_mutex);
+    recordQueueDelay(shop, shop->customer_states[customer_id - 1].called_ns - shop->customer_states[customer_id - 1].sofa_ns);
+}
+
+// Libera a cadeira para o cliente chamado (modo pipeline)
+static void markChairReady(Shop* shop, int customer_id) {
+    pthread_mutex_lock(&shop->chair_mutex);
+    uint64_t now_ns = monotonicNs();
+    shop->customer_states[customer_id - 1].chair_ready = 1;
+    shop->customer_states[customer_id - 1].chair_ready_ns = now_ns;
+    pthread_cond_broadcast(&shop->chair_ready_cond);
+    pthread_mutex_unlock(&shop->chair_mutex);
+    
+    pthread_mutex_lock(&shop->latency_mutex);
+    shop->chair_wait_ns += now_ns - shop->customer_states[customer_id - 1].called_ns;
+    shop->chair_waits++;
+    pthread_mutex_unlock(&shop->latency_mutex);
+}
+
+// Retira o próximo cliente do sofá e o chama, ou retorna -1 se o sofá está vazio.
+// No pipeline, reserving = 1 registra a reserva em nome do barbeiro; com o sofá
+// vazio, um barbeiro livre (reserving = 0) assume a reserva pendente de outro,
+// que ainda está cortando, em vez de dormir enquanto o cliente espera a cadeira
+static int reserveNextCustomer(Shop* shop, int barber_id, const char* action, int reserving) {
+    char log_msg[200];
+    int customer_id = -1;
+    int taken_from = 0;
+    
+    pthread_mutex_lock(&shop->sofa_mutex);
+    if (shop->sofa_queue->size > 0) {
+        customer_id = sofaPop(shop->sofa_queue);
+        if (reserving) {
+            shop->reservations[barber_id - 1] = customer_id;
+        }
+        snprintf(log_msg, sizeof(log_msg), "Barbeiro %d: %s cliente %d para corte", barber_id, action, customer_id);
+        logMessage(shop, log_msg);
+    } else if (shop->config.pipeline && !reserving) {
+        for (int i = 0; i < shop->num_barbers; i++) {
+            if (shop->reservations[i] != -1) {
+                customer_id = shop->reservations[i];
+                shop->reservations[i] = -1;
+                shop->reservation_takeovers++;
+                taken_from = i + 1;
+                snprintf(log_msg, sizeof(log_msg), "Barbeiro %d: Assumiu o cliente %d reservado pelo barbeiro %d",
+                         barber_id, customer_id, taken_from);
+                logMessage(shop, log_msg);
+                break;
+            }
+        }
+    }
+    pthread_mutex_unlock(&shop->sofa_mutex);
+    
+    // Cliente assumido já foi chamado por quem o reservou
+    if (customer_id != -1 && !taken_from) {
+        callCustomer(shop, customer_id);
+    }
+    return customer_id;
+}
+
+// Confirma, ao fim do corte, que a reserva do barbeiro não foi assumida por outro.
+// Retorna o cliente reservado ou -1
+static int claimReservation(Shop* shop, int barber_id) {
+    pthread_mutex_lock(&shop->sofa_mutex);
+    int customer_id = shop->reservations[barber_id - 1];
+    shop->reservations[barber_id - 1] = -1;
+    pthread_mutex_unlock(&shop->sofa_mutex);
+    return customer_id;
+}
+
+// Registra quanto tempo o barbeiro ficou parado num handoff de cadeira
+static void recordHandoffIdle(Shop* shop, uint64_t idle_ns) {
+    pthread_mutex_lock(&shop->latency_mutex);
+    shop->handoff_idle_ns += idle_ns;
+    if (idle_ns > shop->handoff_idle_max_ns) shop->handoff_idle_max_ns = idle_ns;
+    shop->handoffs++;
+    pthread_mutex_unlock(&shop->latency_mutex);
+}
+
+// Corta o cabelo. Se next_customer_id não for NULL (modo pipeline), reserva o
+// próximo cliente do sofá perto do fim do corte para sobrepor o handoff. Com
+// pagamento na fila não reserva: o barbeiro cobra antes de chamar outro cliente,
+// como no modo sem pipeline
+static void cutHair(Shop* shop, int barber_id, int customer_id, int* next_customer_id) {
+    char log_msg[200];
+    
+    snprintf(log_msg, sizeof(log_msg), "Barbeiro %d: Cortando cabelo do cliente %d", barber_id, customer_id);
+    logMessage(shop, log_msg);
+    
+    // Simula tempo de corte conforme a classe do cliente
+    const ShopCustomerClass* cls = &shop->classes[shop->customer_states[customer_id - 1].class_id];
+    int haircut_time = variableRandomTime(cls->min_haircut_time, cls->max_haircut_time, shop->config.variability_factor);
+    if (next_customer_id != NULL) {
+        int lead_ms = haircut_time / 4 < PIPELINE_LEAD_MS ? haircut_time / 4 : PIPELINE_LEAD_MS;
+        usleep((haircut_time - lead_ms) * 1000);
+        
+        pthread_mutex_lock(&shop->payment_mutex);
+        int payment_pending = !isEmpty(shop->payment_queue);
+        pthread_mutex_unlock(&shop->payment_mutex);
+        *next_customer_id = payment_pending ? -1 : reserveNextCustomer(shop, barber_id, "Reservou", 1);
+        usleep(lead_ms * 1000);
+    } else {
+        usleep(haircut_time * 1000);
+    }
+    
+    snprintf(log_msg, sizeof(log_msg), "Barbeiro %d: Terminou corte do cliente %d", barber_id, customer_id);
+    logMessage(shop, log_msg);
+}
+
+static void acceptPayment(Shop* shop, int barber_id, int customer_id) {
+    char log_msg[200];
+    
+    snprintf(log_msg, sizeof(log_msg), "Barbeiro %d: Processando pagamento do cliente %d", barber_id, customer_id);
+    logMessage(shop, log_msg);
+    
+    // Simula tempo de pagamento
+    int payment_time = variableRandomTime(shop->config.min_payment_time, shop->config.max_payment_time, shop->config.variability_factor);
+    usleep(payment_time * 1000);
+    
+    snprintf(log_msg, sizeof(log_msg), "Barbeiro %d: Pagamento do cliente %d processado", barber_id, customer_id);
+    logMessage(shop, log_msg);
+}
+
+// Barbeiros acima do número ativo ficam estacionados em shop->barber_unparked, sem
+// consumir CPU, até o controlador aumentar o pool ou a simulação terminar
+static void waitWhileParked(Shop* shop, int barber_id, uint64_t* active_since_ns) {
+    char log_msg[200];
+    
+    pthread_mutex_lock(&shop->pool_mutex);
+    if (barber_id > shop->active_barbers && !shouldStop(shop)) {
+        shop->barber_active_ns += monotonicNs() - *active_since_ns;
+        snprintf(log_msg, sizeof(log_msg), "Barbeiro %d: Estacionado", barber_id);
+        logMessage(shop, log_msg);
+        
+        while (barber_id > shop->active_barbers && !shouldStop(shop)) {
+            pthread_cond_wait(&shop->barber_unparked, &shop->pool_mutex);
+        }
+        
+        *active_since_ns = monotonicNs();
+        if (!shouldStop(shop)) {
+            snprintf(log_msg, sizeof(log_msg), "Barbeiro %d: Voltou ao trabalho", barber_id);
+            logMessage(shop, log_msg);
+        }
+    }
+    pthread_mutex_unlock(&shop->pool_mutex);
+}
+
+// Thread do barbeiro
+static void* barberThread(void* arg) {
+    Shop* shop = ((ThreadArg*)arg)->shop;
+    int barber_id = ((ThreadArg*)arg)->id;
+    char log_msg[200];
+    
+    snprintf(log_msg, sizeof(log_msg), "Barbeiro %d: Iniciou trabalho", barber_id);
+    logMessage(shop, log_msg);
+    
+    uint64_t active_since_ns = monotonicNs();
+    int next_customer_id = -1; // Cliente reservado durante o corte anterior (modo pipeline)
+    
+    while (!shouldStop(shop)) {
+        // Com cliente reservado o barbeiro não estaciona antes de atendê-lo
+        if (next_customer_id == -1) {
+            waitWhileParked(shop, barber_id, &active_since_ns);
+            if (shouldStop(shop)) break;
+        }
+        
+        int did_work = 0;
+        int customer_id = -1;
+        uint64_t handoff_start_ns = monotonicNs();
+        
+        // PRIMEIRO: Atende o cliente reservado ou chama o próximo do sofá
+        if (next_customer_id != -1) {
+            customer_id = next_customer_id;
+            next_customer_id = -1;
+        } else {
+            customer_id = reserveNextCustomer(shop, barber_id, "Chamando", 0);
+            if (customer_id != -1 && shop->config.pipeline) {
+                markChairReady(shop, customer_id);
+            }
+        }
+        
+        if (customer_id != -1) {
+            did_work = 1;
+            
+            // CRUCIAL: Espera o cliente confirmar que sentou na cadeira
+            uint64_t wait_start_ns = monotonicNs();
+            int waited = 0;
+            pthread_mutex_lock(&shop->chair_mutex);
+            while (!shop->customer_states[customer_id - 1].seated_in_chair) {
+                pthread_cond_wait(&shop->customer_seated, &shop->chair_mutex);
+                waited = 1;
+            }
+            recordLatency(shop, HANDOFF_SEATED_TO_BARBER, waited, shop->customer_states[customer_id - 1].seated_ns,
+                          wait_start_ns, monotonicNs());
+            pthread_mutex_unlock(&shop->chair_mutex);
+            
+            // AGORA o cliente saiu do sofá e sentou na cadeira - libera lugar no sofá
+            // (no pipeline o próprio cliente já liberou)
+            if (!shop->config.pipeline) {
+                releaseSofaSeat(shop);
+            }
+            recordHandoffIdle(shop, monotonicNs() - handoff_start_ns);
+            
+            // Agora sim pode cortar o cabelo (cliente já está sentado)
+            cutHair(shop, barber_id, customer_id, shop->config.pipeline ? &next_customer_id : NULL);
+            
+            // Marca que corte terminou
+            pthread_mutex_lock(&shop->shop_mutex);
+            shop->customers_being_served--;
+            pthread_mutex_unlock(&shop->shop_mutex);
+            
+            pthread_mutex_lock(&shop->chair_mutex);
+            shop->customer_states[customer_id - 1].haircut_done = 1;
+            shop->customer_states[customer_id - 1].haircut_done_ns = monotonicNs();
+            pthread_cond_broadcast(&shop->haircut_done); // Acorda cliente
+            pthread_mutex_unlock(&shop->chair_mutex);
+            
+            // Cadeira livre: o cliente reservado já pode sentar, e o barbeiro o
+            // atende em seguida, sem pagamento nem pausa no meio do handoff.
+            // Se um barbeiro livre assumiu a reserva durante o corte, segue o ciclo normal
+            if (next_customer_id != -1) {
+                next_customer_id = claimReservation(shop, barber_id);
+            }
+            if (next_customer_id != -1) {
+                markChairReady(shop, next_customer_id);
+                continue;
+            }
+            
+            customer_id = -1;
+        }
+        
+        // SEGUNDO: Verifica se há cliente para pagamento
+        pthread_mutex_lock(&shop->payment_mutex);
+        if (!isEmpty(shop->payment_queue)) {
+            customer_id = dequeue(shop->payment_queue);
+            did_work = 1;
+            uint64_t payment_wait_ns = monotonicNs() - shop->customer_states[customer_id - 1].payment_queued_ns;
+            
+            pthread_mutex_unlock(&shop->payment_mutex);
+            recordQueueDelay(shop, payment_wait_ns);
+            
+            // Processa pagamento
+            acceptPayment(shop, barber_id, customer_id);
+            
+            // Marca pagamento como feito e incrementa contador de clientes atendidos
+            pthread_mutex_lock(&shop->payment_mutex);
+            shop->customers_attended++;
+            shop->customer_states[customer_id - 1].payment_done = 1;
+            shop->customer_states[customer_id - 1].payment_done_ns = monotonicNs();
+            pthread_cond_broadcast(&shop->payment_done_cond); // Acorda cliente
+            pthread_mutex_unlock(&shop->payment_mutex);
+        } else {
+            pthread_mutex_unlock(&shop->payment_mutex);
+        }
+        
+        // TERCEIRO: Se não fez trabalho, dorme esperando por corte ou pagamento
+        if (!did_work && !shouldStop(shop)) {
+            snprintf(log_msg, sizeof(log_msg), "Barbeiro %d: Dormindo - sem trabalho", barber_id);
+            logMessage(shop, log_msg);
+            
+            // Escuta tanto por clientes no sofá quanto por pagamentos
+            pthread_mutex_lock(&shop->shop_mutex);
+            if (!shouldStop(shop)) {
+                pthread_cond_wait(&shop->barber_available, &shop->shop_mutex);
+            }
+            pthread_mutex_unlock(&shop->shop_mutex);
+        }
+        
+        // Pequena pausa entre ciclos (interrompida pelo fim da simulação)
+        sleepUnlessStopped(shop, randomTime(50, 150));
+    }
+    
+    pthread_mutex_lock(&shop->pool_mutex);
+    shop->barber_active_ns += monotonicNs() - active_since_ns;
+    pthread_mutex_unlock(&shop->pool_mutex);
+    
+    snprintf(log_msg, sizeof(log_msg), "Barbeiro %d: Terminou trabalho", barber_id);
+    logMessage(shop, log_msg);
+    
+    return NULL;
+}
+
+// Thread do cliente
+static void* customerThread(void* arg) {
+    Shop* shop = ((ThreadArg*)arg)->shop;
+    int customer_id = ((ThreadArg*)arg)->id;
+    char log_msg[200];
+    
+    snprintf(log_msg, sizeof(log_msg), "Cliente %d: Chegou à barbearia", customer_id);
+    logMessage(shop, log_msg);
+    
+    // Tempo para observar a loja antes de entrar
+    usleep(randomTime(50, 200) * 1000);
+    
+    if (!enterShop(shop, customer_id)) {
+        return NULL; // Não conseguiu entrar (balk)
+    }
+    
+    // Processo completo: sofá -> corte -> pagamento
+    sitOnSofa(shop, customer_id);
+    getHairCut(shop, customer_id);
+    pay(shop, customer_id);
+    
+    // Sai da loja AQUI
+    pthread_mutex_lock(&shop->shop_mutex);
+    shop->customers_in_shop--;
+    shop->customer_states[customer_id - 1].left_ns = monotonicNs();
+    notifyMonitor(shop);
+    pthread_mutex_unlock(&shop->shop_mutex);
+    recordSojourn(shop, shop->customer_states[customer_id - 1].left_ns - shop->customer_states[customer_id - 1].entered_ns);
+    
+    snprintf(log_msg, sizeof(log_msg), "Cliente %d: Saiu da barbearia", customer_id);
+    logMessage(shop, log_msg);
+    
+    return NULL;
+}
+
+// Função para verificar condição de parada
+// Sinaliza o fim da simulação e acorda todos os barbeiros, inclusive os
+// estacionados. O aviso vai sob shop_mutex para nenhum barbeiro perdê-lo entre
+// checar should_stop e dormir (com execuções seguidas isso travaria o join)
+static void stopShop(Shop* shop) {
+    pthread_mutex_lock(&shop->shop_mutex);
+    __atomic_store_n(&shop->should_stop, 1, __ATOMIC_RELAXED);
+    pthread_cond_broadcast(&shop->barber_available);
+    pthread_cond_broadcast(&shop->stop_cond);
+    pthread_mutex_unlock(&shop->shop_mutex);
+    
+    pthread_cond_broadcast(&shop->payment_ready);
+    pthread_mutex_lock(&shop->pool_mutex);
+    pthread_cond_broadcast(&shop->barber_unparked);
+    pthread_mutex_unlock(&shop->pool_mutex);
+}
+
+// Reavalia a condição de parada a cada saída ou desistência (monitor_wake), para
+// shopRun terminar assim que o último cliente sai; o timeout só mantém a
+// verificação periódica de consistência
+static void* monitorThread(void* arg) {
+    Shop* shop = (Shop*)arg;
+    while (1) {
+        // Lê variáveis de diferentes mutexes de forma segura
+        pthread_mutex_lock(&shop->shop_mutex);
+        int shop_customers = shop->customers_in_shop;
+        int being_served = shop->customers_being_served;
+        int visits = shop->total_visits;
+        int expected = shop->expected_customers;
+        unsigned long seen_events = shop->shop_events;
+        pthread_mutex_unlock(&shop->shop_mutex);
+        
+        pthread_mutex_lock(&shop->payment_mutex);
+        int paying_customers = shop->customers_paying;
+        pthread_mutex_unlock(&shop->payment_mutex);
+        
+        int active_customers = shop_customers + being_served + paying_customers;
+        
+        // Debug: verifica inconsistências
+        if (shop_customers > shop->config.max_capacity) {
+            char debug_msg[200];
+            snprintf(debug_msg, sizeof(debug_msg), "ERRO: Loja com %d clientes (máx %d)!", 
+                     shop_customers, shop->config.max_capacity);
+            logMessage(shop, debug_msg);
+        }
+        
+        if (visits >= expected && active_customers == 0) {
+            char debug_msg[200];
+            snprintf(debug_msg, sizeof(debug_msg), "Monitor: Condição de parada - visitas=%d, ativos=%d, atendidos=%d", 
+                     visits, active_customers, shop->customers_attended);
+            logMessage(shop, debug_msg);
+            logMessage(shop, "Monitor: Condição de parada atingida - finalizando simulação");
+            
+            stopShop(shop);
+            break;
+        }
+        
+        // Só dorme se nada mudou desde a leitura acima
+        pthread_mutex_lock(&shop->shop_mutex);
+        if (shop->shop_events == seen_events) {
+            timedWait(&shop->monitor_wake, &shop->shop_mutex, 500);
+        }
+        pthread_mutex_unlock(&shop->shop_mutex);
+    }
+    
+    return NULL;
+}
+
+// Thread do controlador do pool elástico de barbeiros
+static void* autoscaleThread(void* arg) {
+    Shop* shop = (Shop*)arg;
+    double backlog_window[AUTOSCALE_WINDOW] = {0};
+    int balk_window[AUTOSCALE_WINDOW] = {0};
+    int samples = 0;
+    int ticks_since_change = 0;
+    char log_msg[200];
+    
+    pthread_mutex_lock(&shop->shop_mutex);
+    int last_balks = shop->customers_balked;
+    pthread_mutex_unlock(&shop->shop_mutex);
+    
+    while (!sleepUnlessStopped(shop, AUTOSCALE_TICK_MS)) {
+        
+        // Amostra profundidade do sofá (sentados + esperando lugar) e fila de pagamento
+        pthread_mutex_lock(&shop->sofa_mutex);
+        int sofa_depth = shop->sofa_queue->size + shop->standing_queue->size;
+        pthread_mutex_unlock(&shop->sofa_mutex);
+        
+        pthread_mutex_lock(&shop->payment_mutex);
+        int payment_backlog = shop->payment_queue->size;
+        pthread_mutex_unlock(&shop->payment_mutex);
+        
+        pthread_mutex_lock(&shop->shop_mutex);
+        int balks = shop->customers_balked;
+        pthread_mutex_unlock(&shop->shop_mutex);
+        
+        pthread_mutex_lock(&shop->pool_mutex);
+        int active = shop->active_barbers;
+        pthread_mutex_unlock(&shop->pool_mutex);
+        
+        int slot = samples % AUTOSCALE_WINDOW;
+        backlog_window[slot] = (double)(sofa_depth + payment_backlog) / active;
+        balk_window[slot] = balks - last_balks;
+        last_balks = balks;
+        samples++;
+        ticks_since_change++;
+        
+        // Só decide com a janela cheia e após uma janela inteira desde a última mudança
+        if (samples < AUTOSCALE_WINDOW || ticks_since_change < AUTOSCALE_WINDOW) {
+            continue;
+        }
+        
+        double avg_backlog = 0;
+        int window_balks = 0;
+        for (int i = 0; i < AUTOSCALE_WINDOW; i++) {
+            avg_backlog += backlog_window[i];
+            window_balks += balk_window[i];
+        }
+        avg_backlog /= AUTOSCALE_WINDOW;
+        
+        int target = active;
+        if ((window_balks > 0 || avg_backlog >= AUTOSCALE_UP_BACKLOG) && active < shop->config.max_barbers) {
+            target = active + 1;
+        } else if (window_balks == 0 && avg_backlog < AUTOSCALE_DOWN_BACKLOG && active > shop->config.min_barbers) {
+            target = active - 1;
+        }
+        if (target == active) {
+            continue;
+        }
+        
+        pthread_mutex_lock(&shop->pool_mutex);
+        shop->active_barbers = target;
+        if (target > active) {
+            shop->scale_up_events++;
+            if (target > shop->peak_active_barbers) shop->peak_active_barbers = target;
+            pthread_cond_broadcast(&shop->barber_unparked);
+        } else {
+            shop->scale_down_events++;
+        }
+        pthread_mutex_unlock(&shop->pool_mutex);
+        
+        // Barbeiro dormindo sem trabalho precisa reavaliar se deve estacionar
+        if (target < active) {
+            pthread_mutex_lock(&shop->shop_mutex);
+            pthread_cond_broadcast(&shop->barber_available);
+            pthread_mutex_unlock(&shop->shop_mutex);
+        }
+        
+        snprintf(log_msg, sizeof(log_msg), "Controlador: %d -> %d barbeiros (fila média %.2f/barbeiro, %d desistências na janela)",
+                 active, target, avg_backlog, window_balks);
+        logMessage(shop, log_msg);
+        ticks_since_change = 0;
+    }
+    
+    return NULL;
+}
+
+// Exibe consumo de barbeiros comparado com vazão e desistências
+static void printStaffingReport(Shop* shop, double elapsed_s) {
+    double barber_seconds = shop->barber_active_ns / 1e9;
+    double static_seconds = shop->num_barbers * elapsed_s;
+    
+    printf("\n=== DIMENSIONAMENTO DOS BARBEIROS ===\n");
+    if (shop->config.autoscale) {
+        printf("Modo: elástico (%d-%d barbeiros, pico %d, %d aumentos, %d reduções)\n",
+               shop->config.min_barbers, shop->config.max_barbers, shop->peak_active_barbers, shop->scale_up_events, shop->scale_down_events);
+    } else {
+        printf("Modo: estático (%d barbeiros)\n", shop->num_barbers);
+    }
+    printf("Duração: %.1fs\n", elapsed_s);
+    printf("Barbeiro-segundos consumidos: %.1f (estático com %d: %.1f, %.0f%%)\n",
+           barber_seconds, shop->num_barbers, static_seconds,
+           static_seconds > 0 ? 100.0 * barber_seconds / static_seconds : 0.0);
+    printf("Vazão: %.3f clientes/s\n", elapsed_s > 0 ? shop->customers_attended / elapsed_s : 0.0);
+    printf("Taxa de desistência: %.1f%% (%d de %d visitas)\n",
+           shop->total_visits > 0 ? 100.0 * shop->customers_balked / shop->total_visits : 0.0, shop->customers_balked, shop->total_visits);
+    if (shop->customers_attended > 0) {
+        printf("Barbeiro-segundos por cliente atendido: %.2f\n", barber_seconds / shop->customers_attended);
+    }
+    if (shop->handoffs > 0) {
+        printf("Barbeiro ocioso por handoff de cadeira (%s): média %.2fms, máx %.2fms em %d handoffs\n",
+               shop->config.pipeline ? "pipeline" : "sequencial", shop->handoff_idle_ns / 1e6 / shop->handoffs,
+               shop->handoff_idle_max_ns / 1e6, shop->handoffs);
+    }
+    if (shop->config.pipeline && shop->chair_waits > 0) {
+        printf("Cliente chamado esperando a cadeira: média %.2fms em %d chamadas, %d reservas assumidas por barbeiro livre\n",
+               shop->chair_wait_ns / 1e6 / shop->chair_waits, shop->chair_waits, shop->reservation_takeovers);
+    }
+}
+
+// Sorteia a classe de um cliente conforme as fatias de chegada
+static int pickCustomerClass(Shop* shop) {
+    int total_share = 0;
+    for (int i = 0; i < shop->num_classes; i++) {
+        total_share += shop->classes[i].share;
+    }
+    
+    int r = randomTime(0, total_share - 1);
+    for (int i = 0; i < shop->num_classes; i++) {
+        if (r < shop->classes[i].share) return i;
+        r -= shop->classes[i].share;
+    }
+    return shop->num_classes - 1;
+}
+
+static int compareUint64(const void* a, const void* b) {
+    uint64_t x = *(const uint64_t*)a;
+    uint64_t y = *(const uint64_t*)b;
+    return (x > y) - (x < y);
+}
+
+// Percentil (vizinho mais próximo) de amostras já ordenadas, em ms
+static double percentileMs(const uint64_t* sorted, int count, int percentile) {
+    int index = (count * percentile + 99) / 100 - 1;
+    if (index < 0) index = 0;
+    return sorted[index] / 1e6;
+}
+
+// Exibe espera no sofá e permanência na loja por classe de cliente
+static void printClassReport(Shop* shop) {
+    const char* dispatch_names[] = { "fifo", "sept", "priority" };
+    uint64_t* waits = shop->scratch_a;
+    uint64_t* sojourns = shop->scratch_b;
+    
+    printf("\n=== LATÊNCIA POR CLASSE (ms, disciplina %s) ===\n", dispatch_names[shop->config.dispatch]);
+    for (int c = 0; c < shop->num_classes; c++) {
+        int count = 0;
+        double wait_sum = 0, sojourn_sum = 0;
+        for (int i = 0; i < shop->config.max_customers; i++) {
+            const CustomerState* st = &shop->customer_states[i];
+            if (st->class_id != c || st->left_ns == 0) continue;
+            waits[count] = st->called_ns - st->sofa_ns;
+            sojourns[count] = st->left_ns - st->entered_ns;
+            wait_sum += waits[count];
+            sojourn_sum += sojourns[count];
+            count++;
+        }
+        
+        printf("%-*s: %d atendidos\n", SHOP_CLASS_NAME_LEN, shop->classes[c].name, count);
+        if (count == 0) continue;
+        
+        qsort(waits, count, sizeof(uint64_t), compareUint64);
+        qsort(sojourns, count, sizeof(uint64_t), compareUint64);
+        printf("  espera no sofá: média=%.0f p50=%.0f p90=%.0f p99=%.0f\n",
+               wait_sum / count / 1e6, percentileMs(waits, count, 50),
+               percentileMs(waits, count, 90), percentileMs(waits, count, 99));
+        printf("  permanência:    média=%.0f p50=%.0f p90=%.0f p99=%.0f\n",
+               sojourn_sum / count / 1e6, percentileMs(sojourns, count, 50),
+               percentileMs(sojourns, count, 90), percentileMs(sojourns, count, 99));
+    }
+}
+
+// Thread do controle de admissão adaptativo
+static void* admissionThread(void* arg) {
+    Shop* shop = (Shop*)arg;
+    uint64_t target_ns = (uint64_t)shop->config.admission_target_ms * 1000000ULL;
+    uint64_t window[ADMISSION_WINDOW];
+    int floor_limit = shop->num_barbers; // Abaixo disso cadeiras ficariam ociosas
+    char log_msg[200];
+    
+    while (!sleepUnlessStopped(shop, ADMISSION_INTERVAL_MS)) {
+        
+        pthread_mutex_lock(&shop->admission_mutex);
+        int count = shop->sojourn_samples < ADMISSION_WINDOW ? shop->sojourn_samples : ADMISSION_WINDOW;
+        memcpy(window, shop->sojourn_window, count * sizeof(uint64_t));
+        uint64_t min_delay_ns = shop->interval_min_delay_ns;
+        shop->interval_min_delay_ns = UINT64_MAX;
+        pthread_mutex_unlock(&shop->admission_mutex);
+        
+        uint64_t p99_ns = 0;
+        if (count >= ADMISSION_MIN_SAMPLES) {
+            qsort(window, count, sizeof(uint64_t), compareUint64);
+            p99_ns = (uint64_t)(percentileMs(window, count, 99) * 1e6);
+        }
+        
+        // Fila persistente: até o cliente mais rápido do intervalo esperou demais
+        int standing_queue = min_delay_ns != UINT64_MAX && min_delay_ns > target_ns / 2;
+        int over_target = p99_ns > target_ns || standing_queue;
+        int has_headroom = count >= ADMISSION_MIN_SAMPLES && p99_ns <= target_ns * 8 / 10 &&
+                           (min_delay_ns == UINT64_MAX || min_delay_ns <= target_ns / 4);
+        
+        int limit = admissionLimit(shop);
+        int new_limit = limit;
+        if (over_target && limit > floor_limit) {
+            int step = limit / 4 > 0 ? limit / 4 : 1;
+            new_limit = limit - step > floor_limit ? limit - step : floor_limit;
+        } else if (!over_target && has_headroom && limit < shop->config.max_capacity) {
+            new_limit = limit + 1;
+        }
+        
+        pthread_mutex_lock(&shop->admission_mutex);
+        if (new_limit < limit) {
+            // Descarta amostras de antes da redução para não reduzir de novo pelo mesmo pico
+            shop->sojourn_samples = 0;
+            shop->admission_decreases++;
+        } else if (new_limit > limit) {
+            shop->admission_increases++;
+        }
+        if (new_limit < shop->admission_min_limit) {
+            shop->admission_min_limit = new_limit;
+        }
+        shop->admission_limit_sum += new_limit;
+        shop->admission_ticks++;
+        pthread_mutex_unlock(&shop->admission_mutex);
+        
+        if (new_limit != limit) {
+            __atomic_store_n(&shop->admission_limit, new_limit, __ATOMIC_RELAXED);
+            snprintf(log_msg, sizeof(log_msg), "Admissão: limite %d -> %d (p99 permanência %.0fms, menor atraso de fila %.0fms)",
+                     limit, new_limit, p99_ns / 1e6, min_delay_ns == UINT64_MAX ? 0.0 : min_delay_ns / 1e6);
+            logMessage(shop, log_msg);
+        }
+    }
+    
+    return NULL;
+}
+
+// Copia e ordena as permanências dos clientes atendidos; retorna quantas
+static int collectSojourns(Shop* shop, uint64_t* sojourns) {
+    int count = 0;
+    for (int i = 0; i < shop->config.max_customers; i++) {
+        if (shop->customer_states[i].left_ns == 0) continue;
+        sojourns[count++] = shop->customer_states[i].left_ns - shop->customer_states[i].entered_ns;
+    }
+    qsort(sojourns, count, sizeof(uint64_t), compareUint64);
+    return count;
+}
+
+// Exibe vazão admitida contra latência de cauda da política de admissão
+static void printAdmissionReport(Shop* shop, double elapsed_s) {
+    uint64_t* sojourns = shop->scratch_a;
+    int count = collectSojourns(shop, sojourns);
+    
+    printf("\n=== CONTROLE DE ADMISSÃO ===\n");
+    if (shop->config.admission_target_ms) {
+        printf("Política: adaptativa (alvo p99 %dms, limite %d-%d, médio %.1f, final %d, %d reduções, %d aumentos)\n",
+               shop->config.admission_target_ms, shop->admission_min_limit, shop->config.max_capacity,
+               shop->admission_ticks > 0 ? (double)shop->admission_limit_sum / shop->admission_ticks : (double)shop->config.max_capacity,
+               admissionLimit(shop), shop->admission_decreases, shop->admission_increases);
+    } else {
+        printf("Política: fixa (max_capacity %d)\n", shop->config.max_capacity);
+    }
+    printf("Admitidos: %d de %d visitas, vazão admitida %.3f clientes/s\n",
+           shop->total_visits - shop->customers_balked, shop->total_visits,
+           elapsed_s > 0 ? (shop->total_visits - shop->customers_balked) / elapsed_s : 0.0);
+    if (count > 0) {
+        printf("Permanência: p50=%.0fms p90=%.0fms p99=%.0fms max=%.0fms\n",
+               percentileMs(sojourns, count, 50), percentileMs(sojourns, count, 90),
+               percentileMs(sojourns, count, 99), sojourns[count - 1] / 1e6);
+    }
+}
+
+// Atributos base de toda thread da simulação: só a pilha reduzida de lock_memory
+static void initThreadAttr(Shop* shop, pthread_attr_t* attr) {
+    pthread_attr_init(attr);
+    if (shop->config.lock_memory) {
+        size_t stack_size = LOCKED_STACK_SIZE;
+#ifdef PTHREAD_STACK_MIN
+        if (stack_size < (size_t)PTHREAD_STACK_MIN) stack_size = PTHREAD_STACK_MIN;
+#endif
+        pthread_attr_setstacksize(attr, stack_size);
+    }
+}
+
+// Cria uma thread com afinidade (cpus, NULL = nenhuma) e prioridade SCHED_FIFO
+// opcionais. Se o sistema recusar esses atributos a criação falha: medir sem a
+// afinidade ou a prioridade pedidas seria medir outra configuração
+static int createThread(Shop* shop, pthread_t* thread, const ShopCpuList* cpus, int fifo_priority,
+                 void* (*start_routine)(void*), void* arg) {
+    pthread_attr_t attr;
+    initThreadAttr(shop, &attr);
+    int result = 0;
+    
+#ifdef __linux__
+    if (cpus != NULL && cpus->count > 0) {
+        cpu_set_t set;
+        CPU_ZERO(&set);
+        for (int i = 0; i < cpus->count; i++) {
+            CPU_SET(cpus->cpus[i], &set); // Faixa garantida por shopValidateConfig
+        }
+        result = pthread_attr_setaffinity_np(&attr, sizeof(cpu_set_t), &set);
+    }
+#endif
+    
+    if (result == 0 && fifo_priority > 0) {
+        struct sched_param param = { .sched_priority = fifo_priority };
+        result = pthread_attr_setinheritsched(&attr, PTHREAD_EXPLICIT_SCHED);
+        if (result == 0) result = pthread_attr_setschedpolicy(&attr, SCHED_FIFO);
+        if (result == 0) result = pthread_attr_setschedparam(&attr, &param);
+    }
+    
+    if (result == 0) {
+        result = pthread_create(thread, &attr, start_routine, arg);
+    }
+    pthread_attr_destroy(&attr);
+    
+    if (result != 0 && ((cpus != NULL && cpus->count > 0) || fifo_priority > 0)) {
+        pthread_mutex_lock(&shop->log_mutex);
+        if (!shop->attr_error_shown) {
+            fprintf(stderr, "Erro: Não foi possível aplicar afinidade/prioridade SCHED_FIFO (%s)\n",
+                    strerror(result));
+            shop->attr_error_shown = 1;
+        }
+        pthread_mutex_unlock(&shop->log_mutex);
+    }
+    
+    return result;
+}
+
+
+// Funções da arena
+static size_t arenaAlignUp(size_t size) {
+    return (size + ARENA_ALIGN - 1) & ~(size_t)(ARENA_ALIGN - 1);
+}
+
+static void* arenaAlloc(Arena* arena, size_t size) {
+    void* ptr = arena->base + arena->used;
+    arena->used += arenaAlignUp(size);
+    return ptr;
+}
+
+// No modo elástico são criadas threads para o máximo, com o excedente estacionado
+static int barberThreadCount(const ShopConfig* config) {
+    return config->autoscale ? config->max_barbers : config->num_barbers;
+}
+
+// Bytes de arena que uma execução com esta configuração precisa
+static size_t shopArenaSize(const ShopConfig* config) {
+    size_t customers = (size_t)config->max_customers;
+    size_t barbers = (size_t)barberThreadCount(config);
+    
+    return arenaAlignUp(sizeof(SofaQueue)) +
+           arenaAlignUp(config->sofa_capacity * sizeof(SofaEntry)) +
+           arenaAlignUp(sizeof(SofaQueue)) +
+           arenaAlignUp(config->max_capacity * sizeof(SofaEntry)) +
+           arenaAlignUp(sizeof(Queue)) +
+           arenaAlignUp(config->max_capacity * sizeof(int)) +
+           arenaAlignUp(customers * sizeof(CustomerState)) +
+           arenaAlignUp(barbers * sizeof(pthread_t)) +
+           arenaAlignUp(barbers * sizeof(ThreadArg)) +
+           arenaAlignUp(barbers * sizeof(int)) +
+           arenaAlignUp(customers * sizeof(pthread_t)) +
+           arenaAlignUp(customers * sizeof(ThreadArg)) +
+           2 * arenaAlignUp(customers * sizeof(uint64_t));
+}
+
+void shopDefaultConfig(ShopConfig* config) {
+    *config = default_config;
+}
+
+// Cada CPU da lista deve existir e estar entre as permitidas ao processo; uma CPU
+// ausente faria pthread_create falhar (EINVAL) no meio da execução
+static int validCpuList(const ShopCpuList* list, const char* who) {
+    if (list->count < 0 || list->count > SHOP_MAX_PINNED_CPUS) {
+        fprintf(stderr, "Erro: Lista de CPUs dos %s inválida\n", who);
+        return 0;
+    }
+    if (list->count == 0) {
+        return 1;
+    }
+    
+#ifdef __linux__
+    cpu_set_t allowed;
+    if (sched_getaffinity(0, sizeof(allowed), &allowed) != 0) {
+        CPU_ZERO(&allowed);
+    }
+    for (int i = 0; i < list->count; i++) {
+        int cpu = list->cpus[i];
+        if (cpu < 0 || cpu >= CPU_SETSIZE || !CPU_ISSET(cpu, &allowed)) {
+            fprintf(stderr, "Erro: CPU %d dos %s não existe ou não está disponível (%d CPUs permitidas)\n",
+                    cpu, who, CPU_COUNT(&allowed));
+            return 0;
+        }
+    }
+    return 1;
+#else
+    fprintf(stderr, "Erro: Afinidade de CPU dos %s não é suportada neste sistema\n", who);
+    return 0;
+#endif
+}
+
+static int validTimeRange(int min_time, int max_time) {
+    return min_time > 0 && min_time < max_time;
+}
+
+int shopValidateConfig(const ShopConfig* config) {
+    if (config == NULL) {
+        fprintf(stderr, "Erro: Configuração ausente\n");
+        return -1;
+    }
+    
+    if (config->max_customers <= 0 || config->max_capacity <= 0 ||
+        config->sofa_capacity <= 0 || (!config->autoscale && config->num_barbers <= 0)) {
+        fprintf(stderr, "Erro: Clientes, capacidade, barbeiros e sofá devem ser positivos\n");
+        return -1;
+    }
+    
+    // randomTime sorteia em [min, max]: intervalos vazios ou negativos quebram o sorteio
+    if (!validTimeRange(config->min_haircut_time, config->max_haircut_time) ||
+        !validTimeRange(config->min_payment_time, config->max_payment_time) ||
+        !validTimeRange(config->min_arrival_interval, config->max_arrival_interval)) {
+        fprintf(stderr, "Erro: Tempos de corte, pagamento e chegada devem ser positivos com MIN < MAX\n");
+        return -1;
+    }
+    
+    if (config->variability_factor < 1 || config->variability_factor > 10) {
+        fprintf(stderr, "Erro: Fator de variabilidade deve estar entre 1 e 10\n");
+        return -1;
+    }
+    
+    if (!validCpuList(&config->pin_barbers, "barbeiros") ||
+        !validCpuList(&config->pin_customers, "clientes")) {
+        return -1;
+    }
+    
+    if (config->barber_fifo_priority < 0) {
+        fprintf(stderr, "Erro: Prioridade SCHED_FIFO inválida\n");
+        return -1;
+    }
+    
+    if (config->autoscale && (config->min_barbers <= 0 || config->min_barbers > config->max_barbers)) {
+        fprintf(stderr, "Erro: Pool elástico deve ter 0 < mínimo (%d) <= máximo (%d)\n",
+                config->min_barbers, config->max_barbers);
+        return -1;
+    }
+    
+    if (config->num_classes < 0 || config->num_classes > SHOP_MAX_CUSTOMER_CLASSES) {
+        fprintf(stderr, "Erro: Número de classes deve estar entre 0 e %d\n", SHOP_MAX_CUSTOMER_CLASSES);
+        return -1;
+    }
+    for (int i = 0; i < config->num_classes; i++) {
+        const ShopCustomerClass* cls = &config->classes[i];
+        if (cls->share <= 0 || cls->priority < 0 ||
+            !validTimeRange(cls->min_haircut_time, cls->max_haircut_time)) {
+            fprintf(stderr, "Erro: Classe %d inválida (fatia e tempos positivos, MIN < MAX)\n", i + 1);
+            return -1;
+        }
+    }
+    
+    if (config->dispatch < SHOP_DISPATCH_FIFO || config->dispatch > SHOP_DISPATCH_PRIORITY) {
+        fprintf(stderr, "Erro: Disciplina do sofá inválida\n");
+        return -1;
+    }
+    
+    if (config->aging_ms <= 0 || config->admission_target_ms < 0) {
+        fprintf(stderr, "Erro: Envelhecimento deve ser positivo e alvo de admissão não negativo\n");
+        return -1;
+    }
+    
+    // Validações de consistência
+    if (config->max_capacity < config->sofa_capacity) {
+        fprintf(stderr, "Erro: Capacidade da loja (%d) deve ser >= lugares no sofá (%d)\n", 
+                config->max_capacity, config->sofa_capacity);
+        return -1;
+    }
+    
+    if (config->max_capacity < barberThreadCount(config)) {
+        fprintf(stderr, "Erro: Capacidade da loja (%d) deve ser >= número de barbeiros (%d)\n", 
+                config->max_capacity, barberThreadCount(config));
+        return -1;
+    }
+    
+    return 0;
+}
+
+int shopReset(Shop* shop, const ShopConfig* config) {
+    if (config != NULL && shopValidateConfig(config) != 0) {
+        return -1;
+    }
+    
+    // A arena só é realocada quando a configuração não cabe mais nela. Isso vem
+    // antes de adotar a nova configuração: se faltar memória, o Shop continua
+    // inteiro com a configuração e a arena anteriores
+    size_t needed = shopArenaSize(config != NULL ? config : &shop->config);
+    if (needed > shop->arena.capacity) {
+        char* base = malloc(needed);
+        if (base == NULL) {
+            fprintf(stderr, "Erro: Sem memória para a arena da simulação (%zu bytes)\n", needed);
+            return -1;
+        }
+        free(shop->arena.base);
+        shop->arena.base = base;
+        shop->arena.capacity = needed;
+    }
+    shop->arena.used = 0;
+    
+    if (config != NULL) {
+        shop->config = *config;
+    }
+    
+    // Sem classes explícitas, todos os clientes formam uma única classe
+    if (shop->config.num_classes == 0) {
+        ShopCustomerClass* cls = &shop->classes[0];
+        snprintf(cls->name, sizeof(cls->name), "padrão");
+        cls->share = 1;
+        cls->min_haircut_time = shop->config.min_haircut_time;
+        cls->max_haircut_time = shop->config.max_haircut_time;
+        cls->priority = 0;
+        shop->num_classes = 1;
+    } else {
+        memcpy(shop->classes, shop->config.classes, shop->config.num_classes * sizeof(ShopCustomerClass));
+        shop->num_classes = shop->config.num_classes;
+    }
+    shop->num_barbers = barberThreadCount(&shop->config);
+    
+    const ShopConfig* c = &shop->config;
+    shop->sofa_queue = arenaAlloc(&shop->arena, sizeof(SofaQueue));
+    shop->sofa_queue->entries = arenaAlloc(&shop->arena, c->sofa_capacity * sizeof(SofaEntry));
+    shop->sofa_queue->capacity = c->sofa_capacity;
+    shop->sofa_queue->size = 0;
+    shop->standing_queue = arenaAlloc(&shop->arena, sizeof(SofaQueue));
+    shop->standing_queue->entries = arenaAlloc(&shop->arena, c->max_capacity * sizeof(SofaEntry));
+    shop->standing_queue->capacity = c->max_capacity;
+    shop->standing_queue->size = 0;
+    shop->payment_queue = arenaAlloc(&shop->arena, sizeof(Queue));
+    shop->payment_queue->slots = arenaAlloc(&shop->arena, c->max_capacity * sizeof(int));
+    shop->payment_queue->capacity = c->max_capacity;
+    shop->payment_queue->head = 0;
+    shop->payment_queue->size = 0;
+    shop->customer_states = arenaAlloc(&shop->arena, c->max_customers * sizeof(CustomerState));
+    shop->barber_threads = arenaAlloc(&shop->arena, shop->num_barbers * sizeof(pthread_t));
+    shop->barber_args = arenaAlloc(&shop->arena, shop->num_barbers * sizeof(ThreadArg));
+    shop->reservations = arenaAlloc(&shop->arena, shop->num_barbers * sizeof(int));
+    for (int i = 0; i < shop->num_barbers; i++) {
+        shop->reservations[i] = -1;
+    }
+    shop->customer_threads = arenaAlloc(&shop->arena, c->max_customers * sizeof(pthread_t));
+    shop->customer_args = arenaAlloc(&shop->arena, c->max_customers * sizeof(ThreadArg));
+    shop->scratch_a = arenaAlloc(&shop->arena, c->max_customers * sizeof(uint64_t));
+    shop->scratch_b = arenaAlloc(&shop->arena, c->max_customers * sizeof(uint64_t));
+    
+    // Inicializa array de estados dos clientes
+    memset(shop->customer_states, 0, c->max_customers * sizeof(CustomerState));
+    for (int i = 0; i < c->max_customers; i++) {
+        shop->customer_states[i].id = i + 1;
+        shop->customer_states[i].class_id = pickCustomerClass(shop);
+    }
+    
+    shop->has_run = 0;
+    shop->customers_in_shop = 0;
+    shop->customers_on_sofa = 0;
+    shop->customers_being_served = 0;
+    shop->customers_paying = 0;
+    shop->total_visits = 0;
+    shop->customers_attended = 0;
+    shop->customers_balked = 0;
+    shop->expected_customers = c->max_customers;
+    shop->shop_events = 0;
+    shop->should_stop = 0;
+    shop->elapsed_s = 0;
+    
+    shop->active_barbers = c->autoscale ? c->min_barbers : shop->num_barbers;
+    shop->peak_active_barbers = shop->active_barbers;
+    shop->scale_up_events = 0;
+    shop->scale_down_events = 0;
+    shop->barber_active_ns = 0;
+    
+    shop->admission_limit = c->max_capacity;
+    shop->sojourn_samples = 0;
+    shop->interval_min_delay_ns = UINT64_MAX;
+    shop->admission_min_limit = c->max_capacity;
+    shop->admission_decreases = 0;
+    shop->admission_increases = 0;
+    shop->admission_limit_sum = 0;
+    shop->admission_ticks = 0;
+    
+    shop->handoff_idle_ns = 0;
+    shop->handoff_idle_max_ns = 0;
+    shop->chair_wait_ns = 0;
+    shop->chair_waits = 0;
+    shop->reservation_takeovers = 0;
+    shop->handoffs = 0;
+    memset(shop->latency_histograms, 0, sizeof(shop->latency_histograms));
+    shop->sofa_arrivals = 0;
+    
+    return 0;
+}
+
+Shop* shopCreate(const ShopConfig* config) {
+    if (shopValidateConfig(config) != 0) {
+        return NULL;
+    }
+    
+    Shop* shop = calloc(1, sizeof(Shop));
+    if (shop == NULL) {
+        return NULL;
+    }
+    
+    pthread_mutex_init(&shop->shop_mutex, NULL);
+    pthread_mutex_init(&shop->sofa_mutex, NULL);
+    pthread_mutex_init(&shop->chair_mutex, NULL);
+    pthread_mutex_init(&shop->payment_mutex, NULL);
+    pthread_mutex_init(&shop->log_mutex, NULL);
+    pthread_mutex_init(&shop->latency_mutex, NULL);
+    pthread_mutex_init(&shop->pool_mutex, NULL);
+    pthread_mutex_init(&shop->admission_mutex, NULL);
+    pthread_cond_init(&shop->sofa_available, NULL);
+    pthread_cond_init(&shop->barber_available, NULL);
+    pthread_cond_init(&shop->haircut_done, NULL);
+    pthread_cond_init(&shop->payment_ready, NULL);
+    pthread_cond_init(&shop->payment_done_cond, NULL);
+    pthread_cond_init(&shop->customer_seated, NULL);
+    pthread_cond_init(&shop->barber_unparked, NULL);
+    pthread_cond_init(&shop->chair_ready_cond, NULL);
+    pthread_cond_init(&shop->monitor_wake, NULL);
+    pthread_cond_init(&shop->stop_cond, NULL);
+    
+    if (shopReset(shop, config) != 0) {
+        shopDestroy(shop);
+        return NULL;
+    }
+    return shop;
+}
+
+int shopRun(Shop* shop) {
+    const ShopConfig* c = &shop->config;
+    if (shop->has_run) {
+        return -1; // Precisa de shopReset antes de executar de novo
+    }
+    shop->has_run = 1;
+    
+    uint64_t start_ns = monotonicNs();
+    
+    // Só as threads efetivamente criadas são esperadas no fim. Se uma criação
+    // falhar (ex.: limite de threads ou de memória travada), as chegadas param e
+    // a simulação termina com quem já está na loja
+    int barbers_created = 0;
+    int customers_created = 0;
+    int monitor_created = 0;
+    int autoscale_created = 0;
+    int admission_created = 0;
+    int error = 0;
+    
+    // Cria threads dos barbeiros
+    for (int i = 0; i < shop->num_barbers && !error; i++) {
+        shop->barber_args[i].shop = shop;
+        shop->barber_args[i].id = i + 1;
+        error = createThread(shop, &shop->barber_threads[i], &c->pin_barbers, c->barber_fifo_priority,
+                             barberThread, &shop->barber_args[i]);
+        if (!error) barbers_created++;
+    }
+    
+    // Cria thread de monitoramento
+    pthread_t monitor_thread;
+    if (!error) {
+        error = createThread(shop, &monitor_thread, NULL, 0, monitorThread, shop);
+        monitor_created = !error;
+    }
+    
+    // Cria controlador do pool elástico
+    pthread_t autoscale_thread;
+    if (!error && c->autoscale) {
+        error = createThread(shop, &autoscale_thread, NULL, 0, autoscaleThread, shop);
+        autoscale_created = !error;
+    }
+    
+    // Cria controle de admissão adaptativo
+    pthread_t admission_thread;
+    if (!error && c->admission_target_ms) {
+        error = createThread(shop, &admission_thread, NULL, 0, admissionThread, shop);
+        admission_created = !error;
+    }
+    
+    // Cria threads dos clientes
+    for (int i = 0; i < c->max_customers && !error; i++) {
+        shop->customer_args[i].shop = shop;
+        shop->customer_args[i].id = i + 1;
+        error = createThread(shop, &shop->customer_threads[i], &c->pin_customers, 0,
+                             customerThread, &shop->customer_args[i]);
+        if (error) break;
+        customers_created++;
+        
+        // Intervalo muito variável entre chegadas de clientes (nada a esperar após o último)
+        if (i + 1 < c->max_customers) {
+            usleep(variableRandomTime(c->min_arrival_interval, c->max_arrival_interval, c->variability_factor) * 1000);
+        }
+    }
+    
+    if (error) {
+        fprintf(stderr, "Erro: Não foi possível criar thread (%s) - encerrando com %d de %d clientes\n",
+                strerror(error), customers_created, c->max_customers);
+        
+        // O monitor encerra quando os clientes já criados saírem; sem monitor,
+        // ainda não há clientes e os barbeiros podem parar direto
+        pthread_mutex_lock(&shop->shop_mutex);
+        shop->expected_customers = customers_created;
+        notifyMonitor(shop);
+        pthread_mutex_unlock(&shop->shop_mutex);
+        if (!monitor_created) {
+            stopShop(shop);
+        }
+    }
+    
+    // Espera todos os clientes terminarem
+    for (int i = 0; i < customers_created; i++) {
+        pthread_join(shop->customer_threads[i], NULL);
+    }
+    
+    // Espera monitor terminar
+    if (monitor_created) {
+        pthread_join(monitor_thread, NULL);
+    }
+    
+    if (autoscale_created) {
+        pthread_join(autoscale_thread, NULL);
+    }
+    if (admission_created) {
+        pthread_join(admission_thread, NULL);
+    }
+    
+    // Espera barbeiros terminarem
+    for (int i = 0; i < barbers_created; i++) {
+        pthread_join(shop->barber_threads[i], NULL);
+    }
+    shop->elapsed_s = (monotonicNs() - start_ns) / 1e9;
+    
+    return error ? -1 : 0;
+}
+
+void shopDestroy(Shop* shop) {
+    if (shop == NULL) {
+        return;
+    }
+    
+    pthread_mutex_destroy(&shop->shop_mutex);
+    pthread_mutex_destroy(&shop->sofa_mutex);
+    pthread_mutex_destroy(&shop->chair_mutex);
+    pthread_mutex_destroy(&shop->payment_mutex);
+    pthread_mutex_destroy(&shop->log_mutex);
+    pthread_mutex_destroy(&shop->latency_mutex);
+    pthread_mutex_destroy(&shop->pool_mutex);
+    pthread_mutex_destroy(&shop->admission_mutex);
+    pthread_cond_destroy(&shop->sofa_available);
+    pthread_cond_destroy(&shop->barber_available);
+    pthread_cond_destroy(&shop->haircut_done);
+    pthread_cond_destroy(&shop->payment_ready);
+    pthread_cond_destroy(&shop->payment_done_cond);
+    pthread_cond_destroy(&shop->customer_seated);
+    pthread_cond_destroy(&shop->barber_unparked);
+    pthread_cond_destroy(&shop->chair_ready_cond);
+    pthread_cond_destroy(&shop->monitor_wake);
+    pthread_cond_destroy(&shop->stop_cond);
+    
+    free(shop->arena.base);
+    free(shop);
+}
+
+const ShopConfig* shopConfig(const Shop* shop) {
+    return &shop->config;
+}
+
+void shopGetResults(Shop* shop, ShopResults* results) {
+    results->total_visits = shop->total_visits;
+    results->customers_attended = shop->customers_attended;
+    results->customers_balked = shop->customers_balked;
+    results->elapsed_s = shop->elapsed_s;
+    results->barber_seconds = shop->barber_active_ns / 1e9;
+    
+    int count = collectSojourns(shop, shop->scratch_a);
+    results->sojourn_p50_ms = count > 0 ? percentileMs(shop->scratch_a, count, 50) : 0.0;
+    results->sojourn_p99_ms = count > 0 ? percentileMs(shop->scratch_a, count, 99) : 0.0;
+}
+
+void shopPrintReport(Shop* shop) {
+    printStaffingReport(shop, shop->elapsed_s);
+    printClassReport(shop);
+    printAdmissionReport(shop, shop->elapsed_s);
+    
+    if (shop->config.measure_latency) {
+        printLatencyHistograms(shop);
+    }
+}
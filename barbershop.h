@@ -0,0 +1,134 @@
+#ifndef BARBERSHOP_H
+#define BARBERSHOP_H
+
+// libbarbershop: simulação reentrante do Problema da Barbearia do Hilzer.
+//
+// Todo o estado de uma simulação fica num contexto Shop, então várias
+// simulações podem rodar em sequência ou em paralelo no mesmo processo:
+//
+//     ShopConfig config;
+//     shopDefaultConfig(&config);
+//     config.verbose = 0;
+//     Shop* shop = shopCreate(&config);
+//     for (int i = 0; i < 1000; i++) {
+//         shopRun(shop);
+//         shopGetResults(shop, &results);
+//         shopReset(shop, NULL);      // ou uma nova configuração
+//     }
+//     shopDestroy(shop);
+//
+// A memória de cada execução vem de uma arena do Shop, dimensionada em
+// shopCreate/shopReset e reaproveitada entre execuções: shopRun não faz malloc.
+
+#include <stdint.h>
+
+#define SHOP_MAX_PINNED_CPUS 256
+#define SHOP_MAX_CUSTOMER_CLASSES 8
+#define SHOP_CLASS_NAME_LEN 16
+
+// Conjunto de CPUs para fixar threads (vazio = sem afinidade)
+typedef struct {
+    int count;
+    int cpus[SHOP_MAX_PINNED_CPUS];
+} ShopCpuList;
+
+// Classe de cliente: serviço próprio e fatia das chegadas
+typedef struct {
+    char name[SHOP_CLASS_NAME_LEN];
+    int share;                   // Peso relativo nas chegadas
+    int min_haircut_time;
+    int max_haircut_time;
+    int priority;                // Menor = mais prioritário (disciplina "priority")
+} ShopCustomerClass;
+
+// Disciplina de atendimento do sofá
+typedef enum {
+    SHOP_DISPATCH_FIFO,          // Ordem de chegada ao sofá
+    SHOP_DISPATCH_SEPT,          // Menor tempo de serviço esperado primeiro
+    SHOP_DISPATCH_PRIORITY       // Prioridade da classe com envelhecimento
+} ShopDispatchPolicy;
+
+// Configurações de uma simulação
+typedef struct {
+    int max_customers;
+    int max_capacity;
+    int num_barbers;
+    int sofa_capacity;
+    int min_haircut_time;
+    int max_haircut_time;
+    int min_payment_time;
+    int max_payment_time;
+    int min_arrival_interval;    // Intervalo mínimo entre chegadas (ms)
+    int max_arrival_interval;    // Intervalo máximo entre chegadas (ms)
+    int variability_factor;      // Fator de variabilidade (1-10)
+    ShopCpuList pin_barbers;     // CPUs permitidas para os barbeiros
+    ShopCpuList pin_customers;   // CPUs permitidas para os clientes
+    int barber_fifo_priority;    // Prioridade SCHED_FIFO dos barbeiros (0 = desligado)
+    int lock_memory;             // mlockall aplicado pelo programa: threads com pilha reduzida
+    int measure_latency;         // Mede latência de acordar em cada handoff
+    int autoscale;               // Pool elástico de barbeiros
+    int min_barbers;             // Mínimo de barbeiros ativos no modo elástico
+    int max_barbers;             // Máximo de barbeiros ativos no modo elástico
+    ShopCustomerClass classes[SHOP_MAX_CUSTOMER_CLASSES];
+    int num_classes;             // 0 = classe única com min/max_haircut_time
+    ShopDispatchPolicy dispatch;
+    int aging_ms;                // Espera que vale um nível de prioridade
+    int admission_target_ms;     // Alvo de p99 de permanência (0 = limite fixo max_capacity)
+    int pipeline;                // Reserva o próximo cliente antes de terminar o corte
+    int verbose;                 // Registra cada evento da simulação no stdout
+} ShopConfig;
+
+// Resumo de uma execução
+typedef struct {
+    int total_visits;
+    int customers_attended;
+    int customers_balked;
+    double elapsed_s;
+    double barber_seconds;       // Tempo somado de barbeiros não estacionados
+    double sojourn_p50_ms;
+    double sojourn_p99_ms;
+} ShopResults;
+
+// Contexto opaco de uma simulação
+typedef struct Shop Shop;
+
+// Preenche a configuração padrão
+void shopDefaultConfig(ShopConfig* config);
+
+// Funções que retornam int seguem uma só convenção: 0 em sucesso e -1 em erro,
+// com o motivo escrito no stderr
+
+// Valida a configuração sem alterá-la. Retorna -1 se for inválida (inclusive NULL)
+int shopValidateConfig(const ShopConfig* config);
+
+// Cria um contexto pronto para shopRun, ou NULL se a configuração for inválida
+Shop* shopCreate(const ShopConfig* config);
+
+// Executa a simulação até todos os clientes saírem. Retorna 0 em sucesso e -1
+// se o contexto já foi executado sem shopReset ou se alguma thread não pôde ser
+// criada; nesse caso as chegadas param, as threads já criadas são esperadas e os
+// resultados cobrem só os clientes que chegaram
+int shopRun(Shop* shop);
+
+// Zera o estado para uma nova execução, opcionalmente com outra configuração
+// (NULL mantém a atual). A arena só cresce se a nova configuração exigir.
+// Retorna 0 em sucesso e -1 se a configuração for inválida ou faltar memória;
+// nesse caso o Shop fica inalterado, com a configuração e a arena anteriores
+int shopReset(Shop* shop, const ShopConfig* config);
+
+// Libera o contexto e sua arena
+void shopDestroy(Shop* shop);
+
+// Configuração do contexto, exatamente como recebida em shopCreate/shopReset.
+// Sem classes explícitas a simulação usa uma classe única com min/max_haircut_time;
+// no modo elástico cria max_barbers threads de barbeiro
+const ShopConfig* shopConfig(const Shop* shop);
+
+// Resumo da última execução
+void shopGetResults(Shop* shop, ShopResults* results);
+
+// Exibe os relatórios da última execução (dimensionamento, classes, admissão
+// e, com measure_latency, os histogramas de latência)
+void shopPrintReport(Shop* shop);
+
+#endif
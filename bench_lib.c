@@ -0,0 +1,179 @@
+#define _GNU_SOURCE // Necessário para usleep/clock_gettime com -std=c99
+
+// Exemplo e bench da libbarbershop: executa várias simulações em sequência
+// reaproveitando o mesmo Shop (com shopReset, variando a configuração) e várias
+// em paralelo, cada thread com o seu Shop. Serve também de carga para rodar sob
+// ThreadSanitizer (make bench-lib SANITIZE=thread).
+//
+// Uso: bench_lib [EXECUÇÕES] [SHOPS_EM_PARALELO]
+
+#include "barbershop.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <pthread.h>
+#include <time.h>
+
+// Resultado de uma série de execuções
+typedef struct {
+    int runs;
+    int failures;
+    int attended;
+    double elapsed_s;
+} BenchSeries;
+
+// Parâmetros de uma thread da fase paralela
+typedef struct {
+    int id;
+    int runs;
+    BenchSeries series;
+} BenchWorker;
+
+static double wallSeconds() {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec + ts.tv_nsec / 1e9;
+}
+
+// Configuração pequena e rápida, sem log de eventos
+static void benchConfig(ShopConfig* config) {
+    shopDefaultConfig(config);
+    config->verbose = 0;
+    config->max_customers = 20;
+    config->max_capacity = 8;
+    config->num_barbers = 2;
+    config->sofa_capacity = 3;
+    config->min_haircut_time = 50;
+    config->max_haircut_time = 150;
+    config->min_payment_time = 10;
+    config->max_payment_time = 30;
+    config->min_arrival_interval = 5;
+    config->max_arrival_interval = 20;
+    config->variability_factor = 1;
+}
+
+// Varia a configuração entre execuções para exercitar shopReset com outra
+// configuração (e o crescimento da arena) além do reset simples
+static void sweepConfig(ShopConfig* config, int run) {
+    benchConfig(config);
+    config->num_barbers = 1 + run % 3;
+    config->max_customers = 20 + 10 * (run % 2);
+    config->pipeline = run % 2;
+    config->dispatch = (ShopDispatchPolicy)(run % 3);
+}
+
+// Executa uma vez e confere os invariantes do resumo
+static int runOnce(Shop* shop, int expected_visits, BenchSeries* series) {
+    ShopResults results;
+
+    if (shopRun(shop) != 0) {
+        series->failures++;
+        return 0;
+    }
+    shopGetResults(shop, &results);
+
+    series->runs++;
+    series->attended += results.customers_attended;
+    if (results.total_visits != expected_visits ||
+        results.customers_attended + results.customers_balked != results.total_visits) {
+        fprintf(stderr, "Erro: resumo inconsistente (visitas %d de %d, atendidos %d, desistências %d)\n",
+                results.total_visits, expected_visits, results.customers_attended, results.customers_balked);
+        series->failures++;
+        return 0;
+    }
+    return 1;
+}
+
+// Série de execuções num único Shop, alternando reset simples e nova configuração
+static void runSeries(int runs, int vary_config, BenchSeries* series) {
+    ShopConfig config;
+    benchConfig(&config);
+
+    Shop* shop = shopCreate(&config);
+    if (shop == NULL) {
+        series->failures++;
+        return;
+    }
+
+    double start = wallSeconds();
+    for (int i = 0; i < runs; i++) {
+        runOnce(shop, shopConfig(shop)->max_customers, series);
+
+        if (vary_config && i % 2 == 0) {
+            sweepConfig(&config, i);
+            if (shopReset(shop, &config) != 0) series->failures++;
+        } else if (shopReset(shop, NULL) != 0) {
+            series->failures++;
+        }
+    }
+    series->elapsed_s = wallSeconds() - start;
+
+    shopDestroy(shop);
+}
+
+static void* benchWorker(void* arg) {
+    BenchWorker* worker = (BenchWorker*)arg;
+    runSeries(worker->runs, worker->id % 2, &worker->series);
+    return NULL;
+}
+
+static void printSeries(const char* name, const BenchSeries* series) {
+    printf("%-12s: %d execuções em %.2fs (%.3fs por execução), %d atendidos, %d falhas\n",
+           name, series->runs, series->elapsed_s,
+           series->runs > 0 ? series->elapsed_s / series->runs : 0.0,
+           series->attended, series->failures);
+}
+
+int main(int argc, char* argv[]) {
+    int runs = argc > 1 ? atoi(argv[1]) : 4;
+    int parallel = argc > 2 ? atoi(argv[2]) : 4;
+    if (runs <= 0 || parallel <= 0) {
+        fprintf(stderr, "Uso: %s [EXECUÇÕES] [SHOPS_EM_PARALELO]\n", argv[0]);
+        return 1;
+    }
+
+    printf("=== BENCH DA LIBBARBERSHOP ===\n");
+
+    // Em sequência: um Shop reaproveitado
+    BenchSeries sequential = {0};
+    runSeries(runs, 1, &sequential);
+    printSeries("sequencial", &sequential);
+
+    // Em paralelo: um Shop por thread
+    BenchWorker* workers = calloc(parallel, sizeof(BenchWorker));
+    pthread_t* threads = calloc(parallel, sizeof(pthread_t));
+    if (workers == NULL || threads == NULL) {
+        fprintf(stderr, "Erro: Sem memória para %d workers\n", parallel);
+        return 1;
+    }
+
+    BenchSeries total = {0};
+    int started = 0;
+    double start = wallSeconds();
+    for (int i = 0; i < parallel; i++) {
+        workers[i].id = i;
+        workers[i].runs = runs;
+        if (pthread_create(&threads[i], NULL, benchWorker, &workers[i]) != 0) {
+            fprintf(stderr, "Erro: Não foi possível criar o worker %d\n", i);
+            total.failures++;
+            break;
+        }
+        started++;
+    }
+    for (int i = 0; i < started; i++) {
+        pthread_join(threads[i], NULL);
+        total.runs += workers[i].series.runs;
+        total.attended += workers[i].series.attended;
+        total.failures += workers[i].series.failures;
+    }
+    total.elapsed_s = wallSeconds() - start;
+
+    char name[32];
+    snprintf(name, sizeof(name), "paralelo x%d", parallel);
+    printSeries(name, &total);
+
+    free(workers);
+    free(threads);
+
+    return sequential.failures + total.failures > 0 ? 1 : 0;
+}